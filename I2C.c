@@ -1,4 +1,5 @@
 #include "I2C.h"
+#include "I2C_capture.h"
 #include <abdrive.h>
 
 extern fdserial *xbee;
@@ -79,43 +80,88 @@ int i2c_readbyte (struct I2C_EEPROM i2c_eep, int byte_add, int *data_out)
 
 int i2c_readpage (struct I2C_EEPROM i2c_eep, int byte_add, int *data_out, int count)    //sequential random read function
 {
-  
-  
+  if(!i2c_readseq_start(i2c_eep, byte_add)) {
+    return FALSE;
+  }
+  for(int i=0; i<count; i++) {
+    if(!i2c_readseq_next(i2c_eep, data_out + i, i == count - 1)) {      //nack and stop after the last byte
+      return FALSE;
+    }
+  }
+  return TRUE;
+}
+
+int i2c_readseq_start (struct I2C_EEPROM i2c_eep, int byte_add)    //sequential read, bytes pulled one at a time by i2c_readseq_next
+{
   init_i2c(i2c_eep.scl_gpio, i2c_eep.sda_gpio);     //reset
   start_signal(i2c_eep.scl_gpio, i2c_eep.sda_gpio); //start
   dev_sel_i2c(i2c_eep.scl_gpio, i2c_eep.sda_gpio, i2c_eep.dev_add + i2c_eep.page, WRITE);    //device address(with 0 as last bit, for dummy write)
   
-  if(!return_ack(i2c_eep.scl_gpio, i2c_eep.sda_gpio,COUNTER_VAL)){     //check if ack is received
+  if(!return_ack(i2c_eep.scl_gpio, i2c_eep.sda_gpio, COUNTER_VAL)){     //check if ack is received
     return FALSE;
   }     
   
-  byte_add_i2c(i2c_eep.scl_gpio, i2c_eep.sda_gpio, byte_add);     //byte address(address we want to write in)
+  byte_add_i2c(i2c_eep.scl_gpio, i2c_eep.sda_gpio, byte_add);     //byte address(address we want to read from)
   
   start_signal(i2c_eep.scl_gpio, i2c_eep.sda_gpio); //start
   dev_sel_i2c(i2c_eep.scl_gpio, i2c_eep.sda_gpio, i2c_eep.dev_add + i2c_eep.page, READ);    //device address(with 1 as last bit)
   
-  if(!return_ack(i2c_eep.scl_gpio, i2c_eep.sda_gpio,COUNTER_VAL)){     //check if ack is received
+  if(!return_ack(i2c_eep.scl_gpio, i2c_eep.sda_gpio, COUNTER_VAL)){     //check if ack is received
     return FALSE;
   } 
-  for(int i=0; i<count; i++) {
-    *(data_out+i) = read_data_out(i2c_eep.scl_gpio, i2c_eep.sda_gpio);    //read data according to CLK movement, store in address of *data_out(local)
-    if(i == count - 1){
-      sda_control(i2c_eep.sda_gpio, HIGH);
-      if(!return_nack(i2c_eep.scl_gpio, i2c_eep.sda_gpio,COUNTER_VAL)){     //check if nack is received
-        return FALSE;
-      } 
-      stop_signal(i2c_eep.scl_gpio, i2c_eep.sda_gpio);    //stop
-    }
-    else {
-      sda_control(i2c_eep.sda_gpio, LOW);       //Give ack from master to slave(EEPROM)
-      scl_control(i2c_eep.scl_gpio, HIGH);
-      scl_control(i2c_eep.scl_gpio, LOW);
-      sda_control(i2c_eep.sda_gpio, HIGH);       //set back to high for EEPROM 
-    }
+  return TRUE;
+}
+
+int i2c_readseq_next (struct I2C_EEPROM i2c_eep, int *data_out, int last)
+{
+  *data_out = read_data_out(i2c_eep.scl_gpio, i2c_eep.sda_gpio);    //read data according to CLK movement, store in address of *data_out(local)
+  if(last){
+    sda_control(i2c_eep.sda_gpio, HIGH);
+    if(!return_nack(i2c_eep.scl_gpio, i2c_eep.sda_gpio, COUNTER_VAL)){     //check if nack is received
+      return FALSE;
+    } 
+    stop_signal(i2c_eep.scl_gpio, i2c_eep.sda_gpio);    //stop
   }
+  else {
+    sda_control(i2c_eep.sda_gpio, LOW);       //Give ack from master to slave(EEPROM)
+    scl_control(i2c_eep.scl_gpio, HIGH);
+    scl_control(i2c_eep.scl_gpio, LOW);
+    sda_control(i2c_eep.sda_gpio, HIGH);       //set back to high for EEPROM 
+  }
+  return TRUE;
+}
+
+int i2c_writer_start (struct I2C_WRITER *writer, struct I2C_EEPROM i2c_eep, int byte_add)
+{
+  writer->i2c_eep  = i2c_eep;
+  writer->byte_add = byte_add;
+  writer->fill     = 0;
+  writer->ok       = TRUE;
   return TRUE;
 }
 
+int i2c_writer_put (struct I2C_WRITER *writer, int data)
+{
+  writer->buf[writer->fill++] = data & 0xFF;
+  if((writer->byte_add + writer->fill) % WRITE_PAGE_SIZE == 0){     //reached page boundary, write before it wraps
+    i2c_writer_end(writer);
+  }
+  return writer->ok;
+}
+
+int i2c_writer_end (struct I2C_WRITER *writer)
+{
+  if(writer->fill == 0) {
+    return writer->ok;
+  }
+  if(writer->ok && !i2c_writepage(writer->i2c_eep, writer->byte_add, writer->buf, writer->fill)){   //after a failed page, skip the rest
+    writer->ok = FALSE;
+  }
+  writer->byte_add += writer->fill;
+  writer->fill = 0;
+  return writer->ok;
+}
+
 int init_gpio (int scl_gpio, int sda_gpio)
 {
   sda_control(sda_gpio, HIGH);
@@ -127,17 +173,22 @@ int init_gpio (int scl_gpio, int sda_gpio)
 int init_i2c (int scl_gpio, int sda_gpio)   //checks if SDA is high before anything happens. If low, stop process
 {
   unsigned long mask;
+  unsigned long sda_read;
   int counter;
   
   pause(DELAY_VAL);      // delay time for back-to-back WR operations
   counter = COUNTER_VAL;
   mask = 0x01 << sda_gpio;
-  while((!(INA & mask))){
+  sda_read = INA & mask;
+  CAP_RECORD(CAP_SAMPLE, sda_gpio, sda_read != 0);
+  while(!sda_read){
     if(counter == 0) {
       dprint(xbee, "Error! SDA stuck to low\n");
       return FALSE;
     }
     counter--;
+    sda_read = INA & mask;
+    CAP_RECORD(CAP_SAMPLE, sda_gpio, sda_read != 0);
   }
   stop_signal(scl_gpio, sda_gpio);
   return TRUE;
@@ -177,6 +228,7 @@ int sda_control (int sda_gpio, int state) {   //sda_gpio = pin number for SDA; s
   // drive 0 = OUTA:0, DIRA:1 / drive 1 = OUTA:ignore, DIRA:0 
   OUTA = OUTA & (~mask);    //drive OUTA low
   DIRA = ((DIRA & (~mask)) | (mask & (~state_mask)));     // 1:OUTA, 0:input; switch direction to OUTA
+  CAP_RECORD(CAP_DIR, sda_gpio, state);
  
   return TRUE;
 }
@@ -191,6 +243,7 @@ int scl_control (int scl_gpio, int state) {   //scl_gpio = pin number for SCL; s
   // drive 0 = OUTA:0, DIRA:1 / drive 1 = OUTA:ignore, DIRA:0 
   OUTA = OUTA & (~mask);    //drive OUTA low
   DIRA = ((DIRA & (~mask)) | (mask & (~state_mask)));     // 1:OUTA, 0:input; switch direction to OUTA
+  CAP_RECORD(CAP_DIR, scl_gpio, state);
  
   return TRUE;
 }
@@ -209,6 +262,7 @@ int return_ack (int scl_gpio, int sda_gpio, int counter)     //acknowledge check
   while(counter){
        input = INA;                 //check INA every count to see if SDA is changed
        sda_read = (input & mask);   //makes whatever pin SDA is linked to to be either 1 or 0
+       CAP_RECORD(CAP_SAMPLE, sda_gpio, sda_read != 0);
        if(sda_read == 0){           //if SDA was driven low by EEPROM(ack signal)
 #ifdef DEBUG_ON       
           dprint(xbee, "counter: %d\n", counter);
@@ -246,6 +300,7 @@ int return_nack (int scl_gpio, int sda_gpio, int counter)     //acknowledge chec
   while(counter){
        input = INA;                 //check INA every count to see if SDA is changed
        sda_read = (input & mask);   //makes whatever pin SDA is linked to to be either 1 or 0
+       CAP_RECORD(CAP_SAMPLE, sda_gpio, sda_read != 0);
        if(sda_read == 0){           //if SDA was driven low by EEPROM(ack signal)
 #ifdef DEBUG_ON       
           dprint(xbee, "counter: %d\n", counter);
@@ -317,10 +372,13 @@ int data_in_i2c (int scl_gpio, int sda_gpio, int hex_num)     //Used for DATA IN
 int read_data_out (int scl_gpio, int sda_gpio)
 {
   unsigned int data_out = 0;
+  int sda_read;
   
   for(int i=7; i>=0; i--) {
     scl_control(scl_gpio, HIGH);
-    data_out = ((data_out & (~i)) | (((INA >> sda_gpio)&0x01) << i));
+    sda_read = (INA >> sda_gpio)&0x01;
+    CAP_RECORD(CAP_SAMPLE, sda_gpio, sda_read);
+    data_out = ((data_out & (~i)) | (sda_read << i));
     scl_control(scl_gpio, LOW);
   }
   return data_out;
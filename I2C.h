@@ -5,6 +5,9 @@
  *
  * @brief This header file provides information about the functions in I2C.c.
 **/
+#ifndef I2C_H
+#define I2C_H
+
 #define SDA 12       //Port P12, original: 29
 #define SCL 11       //Port P11, original: 28
 
@@ -20,7 +23,7 @@
 #define FALSE 0
 
 #define WRITE_PAGE_SIZE 16
-#define READ_PAGE_SIZE 256
+#define READ_PAGE_SIZE 256    //also the size of one block(bytes addressable with an 8-bit byte address)
 #define HIGH  1
 #define LOW   0
 #define WRITE 0   //active low
@@ -49,6 +52,24 @@ struct I2C_EEPROM {   //creates structure so that code is more simplified(combin
 
 
 
+/**
+ * @brief  initializes structure object I2C_WRITER, used by i2c_writer_start/put/end
+ * @member i2c_eep  EEPROM being written
+ * @member byte_add 8-bit data word address of buf[0]
+ * @member buf      bytes waiting for the next page write
+ * @member fill     number of bytes in buf
+ * @member ok       false(0) once any page write failed
+**/
+struct I2C_WRITER {
+  struct I2C_EEPROM i2c_eep;
+  int byte_add;
+  int buf[WRITE_PAGE_SIZE];
+  int fill;
+  int ok;
+};
+
+
+
 /**
  * @brief   write a byte to a specific device address
  *
@@ -117,6 +138,79 @@ int i2c_readpage (struct I2C_EEPROM i2c_eep, int byte_add, int *data_out, int co
 
 
 
+/**
+ * @brief   starts a sequential read of a specific device address without reading any data yet
+ *
+ * @details The function performs the dummy write and the read device select of i2c_readpage, then leaves the bus
+ *          open so that the caller can pull bytes one at a time with i2c_readseq_next. Useful when the number of
+ *          bytes to read is only known while reading(ex. decoding a stream).
+ *
+ * @param i2c_eep  I2C_EEPROM struct object
+ * @param byte_add 8-bit data word address, starting address of the read
+ *
+ * @returns 1 or 0 (true or false), indicates function success or failure, respectively.
+**/
+int i2c_readseq_start (struct I2C_EEPROM i2c_eep, int byte_add);
+
+
+
+/**
+ * @brief   reads the next byte of a sequential read started by i2c_readseq_start
+ *
+ * @details The function reads one 8-bit data word. If last is false, the master acks so the EEPROM moves on to the
+ *          next address. If last is true, the master gives a nack followed by a stop signal, ending the read.
+ *
+ * @param i2c_eep  I2C_EEPROM struct object
+ * @param data_out address of 8-bit data word to store data read
+ * @param last     true(1) if this is the final byte of the read, false(0) otherwise
+ *
+ * @returns 1 or 0 (true or false), indicates function success or failure, respectively.
+**/
+int i2c_readseq_next (struct I2C_EEPROM i2c_eep, int *data_out, int last);
+
+
+
+
+/**
+ * @brief   starts a buffered write of any length at a specific device address
+ *
+ * @details Bytes given to i2c_writer_put are collected and written with i2c_writepage, one page write per 16-byte
+ *          page, so that a page write never wraps around inside a page. Nothing is sent until a page is full or
+ *          i2c_writer_end is called. Once a page write fails, the following pages are dropped instead of written.
+ *
+ * @param writer   I2C_WRITER struct object to initialize
+ * @param i2c_eep  I2C_EEPROM struct object
+ * @param byte_add 8-bit data word address, starting address of the write
+ *
+ * @returns true, or 1.
+**/
+int i2c_writer_start (struct I2C_WRITER *writer, struct I2C_EEPROM i2c_eep, int byte_add);
+
+
+
+/**
+ * @brief   adds one byte to a buffered write, writing the page once it is full
+ *
+ * @param writer I2C_WRITER struct object
+ * @param data   8-bit data word to write
+ *
+ * @returns 1 or 0 (true or false), false if any page write of this writer failed so far.
+**/
+int i2c_writer_put (struct I2C_WRITER *writer, int data);
+
+
+
+/**
+ * @brief   writes the bytes still waiting in a buffered write
+ *
+ * @param writer I2C_WRITER struct object
+ *
+ * @returns 1 or 0 (true or false), false if any page write of this writer failed.
+**/
+int i2c_writer_end (struct I2C_WRITER *writer);
+
+
+
 /**
  * @brief   initializes both gpio number of SCL and SDA
  *
@@ -304,5 +398,4 @@ int data_in_i2c (int scl_gpio, int sda_gpio, int hex_num);
 **/
 int read_data_out (int scl_gpio, int sda_gpio);
 
-
-
+#endif
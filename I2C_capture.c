@@ -0,0 +1,70 @@
+#include "I2C_capture.h"
+#include <abdrive.h>
+
+#ifdef CAPTURE_ON
+
+extern fdserial *xbee;
+
+static struct CAP_EVENT cap_buf[CAP_SIZE];    //ring buffer in hub RAM
+static int cap_head;                          //next slot to write
+static int cap_count;                         //valid events, at most CAP_SIZE
+static int cap_paused;
+static unsigned int cap_known;                //bit n set once a direction of pin n has been recorded
+static unsigned int cap_dir;                  //last direction recorded for pin n
+
+int cap_record (int type, int pin, int value)
+{
+  struct CAP_EVENT *event;
+  unsigned int mask = 0x01 << pin;
+
+  if(cap_paused) {
+    return TRUE;
+  }
+  if(type == CAP_DIR) {
+    if((cap_known & mask) && (((cap_dir & mask) != 0) == (value != 0))) {     //direction unchanged, no event
+      return TRUE;
+    }
+    cap_known |= mask;
+    cap_dir = value ? (cap_dir | mask) : (cap_dir & (~mask));
+  }
+
+  event = &cap_buf[cap_head];
+  event->cnt   = CNT;
+  event->type  = type;
+  event->pin   = pin;
+  event->value = value;
+
+  cap_head = (cap_head + 1) % CAP_SIZE;
+  if(cap_count < CAP_SIZE) {
+    cap_count++;
+  }
+  return TRUE;
+}
+
+int cap_clear (void)
+{
+  cap_head  = 0;
+  cap_count = 0;
+  cap_known = 0;
+  return TRUE;
+}
+
+int cap_dump (void)
+{
+  struct CAP_EVENT *event;
+  int index;
+
+  cap_paused = TRUE;
+  index = (cap_head - cap_count + CAP_SIZE) % CAP_SIZE;    //oldest event
+  dprint(xbee, "CAP %d %d\n", CLKFREQ, cap_count);
+  for(int i=0; i<cap_count; i++) {
+    event = &cap_buf[index];
+    dprint(xbee, "%x %c %d %d\n", event->cnt, event->type, event->pin, event->value);
+    index = (index + 1) % CAP_SIZE;
+  }
+  dprint(xbee, "END\n");
+  cap_paused = FALSE;
+  return TRUE;
+}
+
+#endif
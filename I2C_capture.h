@@ -0,0 +1,102 @@
+/**
+ * @file I2C_capture.h
+ *
+ * @author Kibum Kim
+ *
+ * @brief This header file provides information about the functions in I2C_capture.c.
+ *
+ * @details On-target capture of the bit-banged bus for timing analysis. When the driver is built with CAPTURE_ON
+ *          defined, every SCL/SDA direction change(sda_control/scl_control) and every INA sample of SDA(init_i2c,
+ *          return_ack, return_nack, read_data_out) is recorded with its CNT timestamp into a ring buffer in hub RAM.
+ *          sda_control/scl_control calls that leave the direction as it was(ex. releasing a pin that is already
+ *          released) are not recorded. Samples are always recorded, so every ack poll shows up even when it reads
+ *          the same level as the one before. cap_dump prints the buffer over xbee; tools/cap2vcd.c converts the
+ *          printed dump to a VCD file for GTKWave.
+ *          Recording adds its own cycles to every pin change, so captured periods are those of the capture build.
+ *
+ *          CAPTURE_ON has to reach I2C.c and I2C_capture.c, so define it in the compiler options of
+ *          I2C_project.side(add a line ">-DCAPTURE_ON"), not with a #define in I2C_project.c.
+ *          Without CAPTURE_ON, the ring buffer is not compiled in and CAP_RECORD, cap_clear and cap_dump compile
+ *          to nothing.
+**/
+#ifndef I2C_CAPTURE_H
+#define I2C_CAPTURE_H
+
+#include "I2C.h"
+
+#ifndef CAP_SIZE
+#define CAP_SIZE 512     //number of events kept, oldest are overwritten(8 bytes each)
+#endif
+
+#define CAP_DIR    'D'   //direction change, value: 0 driven low, 1 released(input)
+#define CAP_SAMPLE 'S'   //INA sample, value: pin level read
+
+
+/**
+ * @brief  stores one capture event
+ * @member cnt   CNT at the time of the event
+ * @member type  CAP_DIR or CAP_SAMPLE
+ * @member pin   gpio number
+ * @member value level of the event
+**/
+struct CAP_EVENT {
+  unsigned int cnt;
+  unsigned char type;
+  unsigned char pin;
+  unsigned char value;
+};
+
+
+#ifdef CAPTURE_ON
+
+#define CAP_RECORD(type, pin, value) cap_record((type), (pin), (value))
+
+
+/**
+ * @brief   records one event into the ring buffer
+ *
+ * @details The function stamps the event with CNT and stores it at the head of the ring buffer. If the buffer
+ *          is full, the oldest event is overwritten. A CAP_DIR event with the same value as the last one recorded
+ *          for that pin is dropped. Normally called through CAP_RECORD.
+ *
+ * @param type  CAP_DIR or CAP_SAMPLE
+ * @param pin   gpio number
+ * @param value level of the event
+ *
+ * @returns true, or 1.
+**/
+int cap_record (int type, int pin, int value);
+
+
+
+/**
+ * @brief   empties the ring buffer, the next direction of every pin is recorded again
+ *
+ * @returns true, or 1.
+**/
+int cap_clear (void);
+
+
+
+/**
+ * @brief   prints the ring buffer over xbee, oldest event first
+ *
+ * @details Output format(read by tools/cap2vcd.c):
+ *          CAP <CLKFREQ> <number of events>
+ *          <cnt in hex> <type> <pin> <value>     one line per event
+ *          END
+ *          Recording is paused while printing so that the dump does not capture itself.
+ *
+ * @returns true, or 1.
+**/
+int cap_dump (void);
+
+#else
+
+#define CAP_RECORD(type, pin, value)
+static inline int cap_clear (void) { return TRUE; }
+static inline int cap_dump (void) { return TRUE; }
+
+#endif
+
+#endif
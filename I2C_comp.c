@@ -0,0 +1,164 @@
+#include "I2C_comp.h"
+#include <abdrive.h>
+
+extern fdserial *xbee;
+
+struct comp_sink {    //counts the compressed bytes and, unless dry, passes them to the writer
+  struct I2C_WRITER writer;
+  int total;                  //bytes emitted so far
+  int dry;                    //TRUE: only count bytes, no bus access
+};
+
+static void comp_emit (struct comp_sink *sink, int data)
+{
+  sink->total++;
+  if(!sink->dry) {
+    i2c_writer_put(&sink->writer, data);
+  }
+}
+
+static int comp_run_length (int *data_in, int start, int count)   //number of equal bytes starting at start
+{
+  int run = 1;
+
+  while(start + run < count && run < COMP_MAX_RUN && (data_in[start + run] & 0xFF) == (data_in[start] & 0xFF)) {
+    run++;
+  }
+  return run;
+}
+
+static void comp_encode (struct comp_sink *sink, int *data_in, int count)
+{
+  int i = 0;
+  int run;
+  int lit_end;
+
+  for(int byte=COMP_HEADER_SIZE-1; byte>=0; byte--) {     //header: raw length
+    comp_emit(sink, count >> (8 * byte));
+  }
+
+  while(i < count) {
+    run = comp_run_length(data_in, i, count);
+    if(run >= COMP_MIN_RUN) {
+      comp_emit(sink, 257 - run);
+      comp_emit(sink, data_in[i]);
+      i += run;
+    }
+    else {
+      lit_end = i + run;      //grow literal until the next worthwhile run
+      while(lit_end < count && lit_end - i < COMP_MAX_LITERAL) {
+        run = comp_run_length(data_in, lit_end, count);
+        if(run >= COMP_MIN_RUN) {
+          break;
+        }
+        lit_end += run;
+      }
+      if(lit_end - i > COMP_MAX_LITERAL) {
+        lit_end = i + COMP_MAX_LITERAL;
+      }
+      comp_emit(sink, lit_end - i - 1);
+      for(; i < lit_end; i++) {
+        comp_emit(sink, data_in[i]);
+      }
+    }
+  }
+}
+
+int i2c_writecomp (struct I2C_EEPROM i2c_eep, int byte_add, int *data_in, int count, int *stored)
+{
+  struct comp_sink sink;
+
+  if(count < 0 || count > 0xFFFF) {
+    return FALSE;
+  }
+
+  sink.total = 0;
+  sink.dry   = TRUE;
+  comp_encode(&sink, data_in, count);     //first pass: size only
+
+  if(stored) {
+    *stored = sink.total;
+  }
+  if(byte_add + sink.total > READ_PAGE_SIZE) {
+    dprint(xbee, "Error! compressed size %d does not fit at %x\n", sink.total, byte_add);
+    return FALSE;
+  }
+
+  sink.total = 0;
+  sink.dry   = FALSE;
+  i2c_writer_start(&sink.writer, i2c_eep, byte_add);
+  comp_encode(&sink, data_in, count);     //second pass: write
+
+  return i2c_writer_end(&sink.writer);
+}
+
+static int comp_abort (struct I2C_EEPROM i2c_eep)   //ends an open sequential read when the stream can not be finished
+{
+  int dummy;
+
+  i2c_readseq_next(i2c_eep, &dummy, TRUE);
+  return FALSE;
+}
+
+int i2c_readcomp (struct I2C_EEPROM i2c_eep, int byte_add, int *data_out, int max_count, int *count)
+{
+  int raw_len;
+  int data;
+  int control;
+  int len;
+  int produced = 0;
+
+  *count = 0;
+  if(!i2c_readseq_start(i2c_eep, byte_add)) {
+    return FALSE;
+  }
+
+  raw_len = 0;
+  for(int i=0; i<COMP_HEADER_SIZE; i++) {     //header: raw length
+    i2c_readseq_next(i2c_eep, &data, FALSE);
+    raw_len = (raw_len << 8) | data;
+  }
+
+  if(raw_len == 0) {
+    comp_abort(i2c_eep);
+    return TRUE;
+  }
+  if(raw_len > max_count) {
+    dprint(xbee, "Error! compressed block too big: %d\n", raw_len);
+    return comp_abort(i2c_eep);
+  }
+
+  while(produced < raw_len) {
+    i2c_readseq_next(i2c_eep, &control, FALSE);
+    if(control < 128) {             //literal
+      len = control + 1;
+      if(produced + len > raw_len) {
+        return comp_abort(i2c_eep);
+      }
+      for(int i=0; i<len; i++) {
+        if(!i2c_readseq_next(i2c_eep, &data_out[produced], produced == raw_len - 1)) {     //nack on the final byte of the block
+          return FALSE;
+        }
+        produced++;
+      }
+    }
+    else if(control > 128) {        //run
+      len = 257 - control;
+      if(produced + len > raw_len) {
+        return comp_abort(i2c_eep);
+      }
+      if(!i2c_readseq_next(i2c_eep, &data, produced + len == raw_len)) {
+        return FALSE;
+      }
+      for(int i=0; i<len; i++) {
+        data_out[produced++] = data;
+      }
+    }
+    else {                          //128 is never written
+      return comp_abort(i2c_eep);
+    }
+  }
+
+  *count = produced;
+  return TRUE;
+}
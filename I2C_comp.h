@@ -0,0 +1,64 @@
+/**
+ * @file I2C_comp.h
+ *
+ * @author Kibum Kim
+ *
+ * @brief This header file provides information about the functions in I2C_comp.c.
+ *
+ * @details Optional storage layer on top of the page write/sequential read functions of I2C.c. Blocks are stored
+ *          run-length compressed(PackBits style) so that repetitive tables send fewer bytes over the bus and take
+ *          fewer page write cycles. Stored layout, starting at the byte address given:
+ *          byte 0-1 raw length(high byte first)
+ *          byte 2.. compressed stream, made of
+ *                   control 0-127   : (control + 1) literal bytes follow
+ *                   control 129-255 : next byte is repeated (257 - control) times
+ *          A stored block has to fit inside one READ_PAGE_SIZE(256-byte) block of the EEPROM(the one selected by page).
+**/
+#ifndef I2C_COMP_H
+#define I2C_COMP_H
+
+#include "I2C.h"
+
+#define COMP_HEADER_SIZE 2      //raw length, high byte first
+#define COMP_MAX_LITERAL 128
+#define COMP_MAX_RUN     128
+#define COMP_MIN_RUN     3      //shorter repeats are cheaper to keep inside a literal
+
+
+/**
+ * @brief   compresses data and writes it to a specific device address
+ *
+ * @details The function compresses data_in once without touching the bus to check that the result fits in the
+ *          rest of the 256-byte block. If it fits, it compresses again while streaming the result out through
+ *          i2c_writepage, one write per 16-byte page so that page writes never wrap.
+ *
+ * @param i2c_eep  I2C_EEPROM struct object
+ * @param byte_add 8-bit data word address, starting address of the stored block
+ * @param data_in  address of data words to compress and write(one 8-bit data word per int)
+ * @param count    number of data words to write(0 to 65535)
+ * @param stored   address to store the number of bytes written to the EEPROM(header included), can be NULL
+ *
+ * @returns 1 or 0 (true or false), indicates function success or failure, respectively.
+**/
+int i2c_writecomp (struct I2C_EEPROM i2c_eep, int byte_add, int *data_in, int count, int *stored);
+
+
+
+/**
+ * @brief   reads and decompresses a block written by i2c_writecomp
+ *
+ * @details The function starts one sequential read at byte_add and decompresses while the bytes come in, so no
+ *          buffer for the compressed data is needed and the read stops right after the last compressed byte.
+ *
+ * @param i2c_eep   I2C_EEPROM struct object
+ * @param byte_add  8-bit data word address, starting address of the stored block
+ * @param data_out  address of data words to store the decompressed data
+ * @param max_count size of data_out
+ * @param count     address to store the number of data words decompressed
+ *
+ * @returns 1 or 0 (true or false), indicates function success or failure(bus error, block bigger than max_count
+ *          or corrupt block), respectively.
+**/
+int i2c_readcomp (struct I2C_EEPROM i2c_eep, int byte_add, int *data_out, int max_count, int *count);
+
+#endif
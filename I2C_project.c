@@ -7,6 +7,9 @@
 #include <stdlib.h> 
 #include <abdrive.h>
 #include "I2C.h"
+#include "I2C_comp.h"
+#include "I2C_capture.h"
+#include "I2C_snap.h"
 
 fdserial *xbee;
 
@@ -60,6 +63,62 @@ int main()                                    // Main function
     dprint(xbee, "%x ",read_page[i]);
   }
 
+  cap_dump();                                   //no-op unless built with -DCAPTURE_ON(I2C_project.side compiler options), convert the output with tools/cap2vcd
+
+  /*
+  int stored;                                   //benchmark code(raw page path vs compressed path)
+  int count;
+  unsigned int ticks;
+
+  for(int i=0; i<READ_PAGE_SIZE; i++) {         //repetitive table: zero fill followed by a short pattern
+    read_page[i] = (i < 192) ? 0 : (i & 0x03);
+  }
+
+  ticks = CNT;
+  for(int i=0; i<READ_PAGE_SIZE; i+=WRITE_PAGE_SIZE) {
+    i2c_writepage(i2c_eep, i, read_page + i, WRITE_PAGE_SIZE);
+  }
+  dprint(xbee, "\nraw write: %d bytes, %d us\n", READ_PAGE_SIZE, (CNT - ticks) / (CLKFREQ / 1000000));
+
+  ticks = CNT;
+  i2c_readpage(i2c_eep, 0x0, read_page, READ_PAGE_SIZE);
+  dprint(xbee, "raw read:  %d bytes, %d us\n", READ_PAGE_SIZE, (CNT - ticks) / (CLKFREQ / 1000000));
+
+  ticks = CNT;
+  i2c_writecomp(i2c_eep, 0x0, read_page, READ_PAGE_SIZE, &stored);
+  dprint(xbee, "comp write: %d bytes, %d us\n", stored, (CNT - ticks) / (CLKFREQ / 1000000));
+
+  ticks = CNT;
+  i2c_readcomp(i2c_eep, 0x0, read_page, READ_PAGE_SIZE, &count);
+  dprint(xbee, "comp read:  %d bytes, %d us\n", count, (CNT - ticks) / (CLKFREQ / 1000000));
+  dprint(xbee, "ratio: %d/%d\n", stored, READ_PAGE_SIZE);
+  */
+
+  /*
+  struct I2C_SNAP snap;                         //example/benchmark code for snapshot save and boot restore
+  int settings[16];
+  unsigned int ticks;
+
+  snap.slot_eep[0] = i2c_eep;                   //slot B right after slot A on the same page: restore is one read
+  snap.slot_eep[1] = i2c_eep;
+  snap.slot_size   = SNAP_HEADER_SIZE + sizeof(settings) + SNAP_CRC_SIZE;
+  snap.slot_add[0] = 0x00;
+  snap.slot_add[1] = snap.slot_size;
+
+  ticks = CNT;
+  if(!i2c_snap_load(&snap, settings, sizeof(settings))) {
+    for(int i=0; i<16; i++) {                   //no valid snapshot: defaults
+      settings[i] = i;
+    }
+  }
+  dprint(xbee, "\nrestore: slot %d, generation %d, %d us\n", snap.active, snap.generation, (CNT - ticks) / (CLKFREQ / 1000000));
+
+  settings[0]++;
+  ticks = CNT;
+  i2c_snap_save(&snap, settings, sizeof(settings));
+  dprint(xbee, "save: slot %d, generation %d, %d us\n", snap.active, snap.generation, (CNT - ticks) / (CLKFREQ / 1000000));
+  */
+
   
 }
 
@@ -0,0 +1,220 @@
+#include "I2C_snap.h"
+#include <abdrive.h>
+
+extern fdserial *xbee;
+
+#define SNAP_INVALID 0     //results of snap_read_slot
+#define SNAP_OLDER   1
+#define SNAP_LOADED  2
+#define SNAP_TORN    3     //newer slot failed its CRC after overwriting the loaded one in state
+
+struct snap_reader {    //sequential read kept open across slots
+  struct I2C_EEPROM i2c_eep;
+  int byte_add;               //address of the next byte
+  int open;
+  int ok;
+};
+
+static unsigned int snap_crc (unsigned int crc, int data)    //CRC-16/CCITT, one byte at a time
+{
+  crc ^= (data & 0xFF) << 8;
+  for(int i=0; i<8; i++) {
+    if(crc & 0x8000) {
+      crc = (crc << 1) ^ 0x1021;
+    }
+    else {
+      crc = crc << 1;
+    }
+  }
+  return crc & 0xFFFF;
+}
+
+static int snap_newer (unsigned int gen_a, unsigned int gen_b)    //true if gen_a is after gen_b, 16-bit wrap safe
+{
+  unsigned int diff = (gen_a - gen_b) & 0xFFFF;
+
+  return (diff != 0) && (diff < 0x8000);
+}
+
+static int snap_same_block (struct I2C_EEPROM eep_a, struct I2C_EEPROM eep_b)
+{
+  return eep_a.scl_gpio == eep_b.scl_gpio && eep_a.sda_gpio == eep_b.sda_gpio
+         && eep_a.dev_add + eep_a.page == eep_b.dev_add + eep_b.page;
+}
+
+static int snap_fits (struct I2C_SNAP *snap, int size)    //struct fits both slots, slots inside their block and apart
+{
+  int distance;
+
+  if(size < 0 || SNAP_HEADER_SIZE + size + SNAP_CRC_SIZE > snap->slot_size) {
+    return FALSE;
+  }
+  for(int slot=0; slot<SNAP_SLOTS; slot++) {
+    if(snap->slot_add[slot] < 0 || snap->slot_add[slot] + snap->slot_size > READ_PAGE_SIZE) {
+      return FALSE;
+    }
+  }
+  distance = snap->slot_add[1] - snap->slot_add[0];
+  if(distance < 0) {
+    distance = -distance;
+  }
+  if(snap_same_block(snap->slot_eep[0], snap->slot_eep[1]) && distance < snap->slot_size) {
+    return FALSE;
+  }
+  return TRUE;
+}
+
+static int snap_next (struct snap_reader *reader)
+{
+  int data;
+
+  reader->ok &= i2c_readseq_next(reader->i2c_eep, &data, FALSE);
+  reader->byte_add++;
+  return data;
+}
+
+static void snap_close (struct snap_reader *reader)    //the last byte is only known afterwards, so end with a spare one
+{
+  int data;
+
+  if(reader->open) {
+    i2c_readseq_next(reader->i2c_eep, &data, TRUE);
+    reader->open = FALSE;
+  }
+}
+
+static void snap_seek (struct snap_reader *reader, struct I2C_EEPROM i2c_eep, int byte_add)
+{
+  if(reader->open && snap_same_block(reader->i2c_eep, i2c_eep) && byte_add >= reader->byte_add
+     && byte_add - reader->byte_add <= SNAP_SEEK_MAX) {
+    while(reader->byte_add < byte_add) {      //short gap, cheaper than a new read
+      snap_next(reader);
+    }
+    return;
+  }
+  snap_close(reader);
+  reader->i2c_eep  = i2c_eep;
+  reader->byte_add = byte_add;
+  reader->open     = i2c_readseq_start(i2c_eep, byte_add);
+}
+
+static int snap_read_slot (struct snap_reader *reader, struct I2C_SNAP *snap, int slot, unsigned char *state, int size)
+{
+  int header[SNAP_HEADER_SIZE];
+  unsigned int crc = 0xFFFF;
+  unsigned int stored_crc = 0;
+  unsigned int generation;
+
+  snap_seek(reader, snap->slot_eep[slot], snap->slot_add[slot]);
+  if(!reader->open) {
+    return SNAP_INVALID;
+  }
+  reader->ok = TRUE;
+
+  for(int i=0; i<SNAP_HEADER_SIZE; i++) {
+    header[i] = snap_next(reader);
+    crc = snap_crc(crc, header[i]);
+  }
+  if(!reader->ok || header[0] != SNAP_MAGIC || ((header[3] << 8) | header[4]) != size) {
+    return SNAP_INVALID;
+  }
+  generation = (header[1] << 8) | header[2];
+  if(snap->active >= 0 && !snap_newer(generation, snap->generation)) {
+    return SNAP_OLDER;                        //keep what is loaded, skip the struct bytes
+  }
+
+  for(int i=0; i<size; i++) {                 //struct bytes, straight into state
+    state[i] = snap_next(reader);
+    crc = snap_crc(crc, state[i]);
+  }
+  for(int i=0; i<SNAP_CRC_SIZE; i++) {
+    stored_crc = (stored_crc << 8) | snap_next(reader);
+  }
+
+  if(!reader->ok || stored_crc != crc) {
+    dprint(xbee, "Error! snapshot slot %d invalid\n", slot);
+    return (snap->active >= 0) ? SNAP_TORN : SNAP_INVALID;
+  }
+  snap->generation = generation;
+  snap->active = slot;
+  return SNAP_LOADED;
+}
+
+int i2c_snap_save (struct I2C_SNAP *snap, void *state, int size)
+{
+  struct I2C_WRITER writer;
+  int header[SNAP_HEADER_SIZE];
+  unsigned char *bytes = state;
+  unsigned int generation;
+  unsigned int crc = 0xFFFF;
+  unsigned int stored_crc;
+  int slot;
+
+  slot = (snap->active == 0) ? 1 : 0;
+  if(!snap_fits(snap, size)) {
+    dprint(xbee, "Error! snapshot of %d bytes does not fit the slots\n", size);
+    return FALSE;
+  }
+  generation = (snap->generation + 1) & 0xFFFF;
+
+  header[0] = SNAP_MAGIC;
+  header[1] = generation >> 8;
+  header[2] = generation & 0xFF;
+  header[3] = size >> 8;
+  header[4] = size & 0xFF;
+
+  i2c_writer_start(&writer, snap->slot_eep[slot], snap->slot_add[slot]);
+  for(int i=0; i<SNAP_HEADER_SIZE; i++) {
+    crc = snap_crc(crc, header[i]);
+    i2c_writer_put(&writer, header[i]);
+  }
+  for(int i=0; i<size; i++) {
+    crc = snap_crc(crc, bytes[i]);
+    i2c_writer_put(&writer, bytes[i]);
+  }
+  stored_crc = crc;
+  i2c_writer_put(&writer, stored_crc >> 8);      //CRC last, a torn save fails the check
+  i2c_writer_put(&writer, stored_crc);
+
+  if(!i2c_writer_end(&writer)) {
+    return FALSE;
+  }
+  snap->generation = generation;
+  snap->active = slot;
+  return TRUE;
+}
+
+int i2c_snap_load (struct I2C_SNAP *snap, void *state, int size)
+{
+  struct snap_reader reader;
+  int first = 0;
+  int torn = FALSE;
+
+  snap->generation = 0;
+  snap->active = -1;
+  if(!snap_fits(snap, size)) {
+    dprint(xbee, "Error! snapshot of %d bytes does not fit the slots\n", size);
+    return FALSE;
+  }
+
+  if(snap_same_block(snap->slot_eep[0], snap->slot_eep[1]) && snap->slot_add[1] < snap->slot_add[0]) {
+    first = 1;                                //address order, so both slots can share one read
+  }
+
+  reader.open = FALSE;
+  for(int i=0; i<SNAP_SLOTS; i++) {
+    if(snap_read_slot(&reader, snap, i ? 1 - first : first, state, size) == SNAP_TORN) {
+      torn = TRUE;
+    }
+  }
+  snap_close(&reader);
+
+  if(torn) {                                  //newest slot is torn and overwrote state, read the valid one again
+    int slot = snap->active;
+
+    snap->active = -1;
+    snap_read_slot(&reader, snap, slot, state, size);
+    snap_close(&reader);
+  }
+  return snap->active >= 0;
+}
@@ -0,0 +1,95 @@
+/**
+ * @file I2C_snap.h
+ *
+ * @author Kibum Kim
+ *
+ * @brief This header file provides information about the functions in I2C_snap.c.
+ *
+ * @details A/B snapshots of an application struct. Each save goes to the slot that does not hold the newest
+ *          snapshot, so a power loss during a save leaves the previous snapshot intact. Slot layout:
+ *          byte 0                 SNAP_MAGIC
+ *          byte 1-2               generation(high byte first), incremented on every save
+ *          byte 3-4               size of the struct(high byte first)
+ *          byte 5..5+size-1       struct bytes
+ *          last 2 bytes           CRC-16/CCITT of everything above(high byte first)
+ *          The CRC is written last, so a torn save fails the CRC check(barring a 1 in 65536 chance match).
+ *          Each slot reserves slot_size bytes, inside one READ_PAGE_SIZE(256-byte) block of the EEPROM(the one
+ *          selected by page). Slots in the same block must not overlap.
+ *          Boot restore is fastest with both slots in the same block and slot B right after slot A: the load is then
+ *          a single sequential read(one init_i2c pause) covering both slots.
+**/
+#ifndef I2C_SNAP_H
+#define I2C_SNAP_H
+
+#include "I2C.h"
+
+#define SNAP_MAGIC       0x5A
+#define SNAP_HEADER_SIZE 5
+#define SNAP_CRC_SIZE    2
+#define SNAP_SLOTS       2
+#define SNAP_SEEK_MAX    16     //largest gap clocked through to reach the next slot in the same read instead of
+                                //starting a new read(10 ms init_i2c pause); not measured, tune on the target
+
+
+/**
+ * @brief  initializes structure object I2C_SNAP
+ * @member slot_eep   EEPROM(device address and page) of slot A and slot B
+ * @member slot_add   starting byte address of slot A and slot B
+ * @member slot_size  bytes reserved for each slot, at least SNAP_HEADER_SIZE + struct size + SNAP_CRC_SIZE
+ * @member generation generation of the newest valid snapshot, set by i2c_snap_load and i2c_snap_save
+ * @member active     slot(0 or 1) holding the newest valid snapshot, -1 if there is none
+ * example: both slots on page 0, 64-byte struct, slot A at 0x00, slot B right after it at 0x48
+ * slot_eep[0] = slot_eep[1] = i2c_eep;
+ * slot_size   = 0x48;
+ * slot_add[0] = 0x00;
+ * slot_add[1] = 0x48;
+ * generation  = 0;
+ * active      = -1;
+**/
+struct I2C_SNAP {
+  struct I2C_EEPROM slot_eep[SNAP_SLOTS];
+  int slot_add[SNAP_SLOTS];
+  int slot_size;
+  unsigned int generation;
+  int active;
+};
+
+
+
+/**
+ * @brief   saves a struct into the older of the two slots
+ *
+ * @details The function writes header, struct bytes and CRC as page writes(one per 16-byte page) into the slot
+ *          that is not active, with the generation after the active one. The active slot is only switched
+ *          once every page write succeeded. Nothing is written unless the struct fits both slots and the slots
+ *          do not overlap.
+ *
+ * @param snap  I2C_SNAP struct object
+ * @param state address of the struct to save
+ * @param size  size of the struct in bytes
+ *
+ * @returns 1 or 0 (true or false), indicates function success or failure, respectively.
+**/
+int i2c_snap_save (struct I2C_SNAP *snap, void *state, int size);
+
+
+
+/**
+ * @brief   loads the newest valid snapshot into a struct
+ *
+ * @details The function reads the slots in address order with one sequential read, straight into the struct,
+ *          checking the CRC on the way. A slot is only read past its header if it is newer than the one already
+ *          loaded, and the read stops after the last header when it is not. When the slots are in different blocks
+ *          or far apart, each slot takes its own read. If the newest slot turns out torn or corrupt, the older
+ *          valid slot is read again. A slot saved with a different size is never loaded.
+ *
+ * @param snap  I2C_SNAP struct object, generation and active are updated
+ * @param state address of the struct to load into
+ * @param size  size of the struct in bytes
+ *
+ * @returns 1 or 0 (true or false). On false no valid snapshot was found and the contents of state are undefined,
+ *          so the caller should fall back to its defaults.
+**/
+int i2c_snap_load (struct I2C_SNAP *snap, void *state, int size);
+
+#endif
@@ -0,0 +1,144 @@
+/**
+ * @file cap2vcd.c
+ *
+ * @author Kibum Kim
+ *
+ * @brief Converts a capture dump printed by cap_dump(I2C_capture.c) to a VCD file for GTKWave.
+ *
+ * @details Runs on the Linux host, not on the Propeller. Lines before the "CAP" header(ex. other xbee output in
+ *          the same serial log) are skipped. Every gpio number found in the dump gets two signals:
+ *          pN_out  level the master lets the pin go to(0 driven low, 1 released)
+ *          pN_in   level sampled from INA
+ *          CNT wrap-around is handled as long as two events are less than 2^32 clocks apart.
+ *
+ *          build: gcc -std=c99 -o cap2vcd cap2vcd.c
+ *          use:   ./cap2vcd [dump.txt [out.vcd]]      (stdin/stdout by default)
+**/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#define OUTA_pins 32
+#define LINE_SIZE 128
+
+struct event {
+  uint64_t ns;
+  char type;
+  int pin;
+  int value;
+};
+
+static char signal_id (int pin, char type)    //VCD identifier, printable and unique per pin/type
+{
+  return (char)('!' + pin * 2 + (type == 'S'));
+}
+
+int main (int argc, char **argv)
+{
+  FILE *in = stdin;
+  FILE *out = stdout;
+  char line[LINE_SIZE];
+  unsigned long clkfreq = 0;
+  int expected = 0;
+  int count = 0;
+  struct event *events;
+  int used[OUTA_pins][2] = {{0}};
+  unsigned int cnt;
+  unsigned int prev_cnt = 0;
+  uint64_t ticks = 0;
+  uint64_t last_ns;
+  char type;
+  int pin;
+  int value;
+
+  if(argc > 1 && !(in = fopen(argv[1], "r"))) {
+    perror(argv[1]);
+    return 1;
+  }
+  if(argc > 2 && !(out = fopen(argv[2], "w"))) {
+    perror(argv[2]);
+    return 1;
+  }
+
+  while(fgets(line, sizeof(line), in)) {    //find header
+    if(sscanf(line, "CAP %lu %d", &clkfreq, &expected) == 2) {
+      break;
+    }
+  }
+  if(clkfreq == 0 || expected < 0) {
+    fprintf(stderr, "Error! no CAP header found\n");
+    return 1;
+  }
+
+  events = calloc(expected ? expected : 1, sizeof(*events));
+  if(!events) {
+    fprintf(stderr, "Error! out of memory\n");
+    return 1;
+  }
+
+  while(count < expected && fgets(line, sizeof(line), in)) {
+    if(strncmp(line, "END", 3) == 0) {
+      break;
+    }
+    if(sscanf(line, "%x %c %d %d", &cnt, &type, &pin, &value) != 4 || pin < 0 || pin >= OUTA_pins
+       || (type != 'D' && type != 'S')) {
+      fprintf(stderr, "skipping bad line: %s", line);
+      continue;
+    }
+    if(count > 0) {
+      ticks += (uint32_t)(cnt - prev_cnt);     //unsigned difference survives CNT wrap
+    }
+    prev_cnt = cnt;
+
+    events[count].ns    = ticks / clkfreq * 1000000000ULL + (ticks % clkfreq) * 1000000000ULL / clkfreq;    //no 64-bit overflow on long dumps
+    events[count].type  = type;
+    events[count].pin   = pin;
+    events[count].value = value ? 1 : 0;
+    used[pin][type == 'S'] = 1;
+    count++;
+  }
+  if(count != expected) {
+    fprintf(stderr, "warning: %d of %d events read\n", count, expected);
+  }
+
+  fprintf(out, "$timescale 1ns $end\n");
+  fprintf(out, "$scope module i2c $end\n");
+  for(int p=0; p<OUTA_pins; p++) {
+    if(used[p][0]) {
+      fprintf(out, "$var wire 1 %c p%d_out $end\n", signal_id(p, 'D'), p);
+    }
+    if(used[p][1]) {
+      fprintf(out, "$var wire 1 %c p%d_in $end\n", signal_id(p, 'S'), p);
+    }
+  }
+  fprintf(out, "$upscope $end\n$enddefinitions $end\n");
+
+  fprintf(out, "#0\n$dumpvars\n");      //unknown until the first event of each signal
+  for(int p=0; p<OUTA_pins; p++) {
+    for(int s=0; s<2; s++) {
+      if(used[p][s]) {
+        fprintf(out, "x%c\n", signal_id(p, s ? 'S' : 'D'));
+      }
+    }
+  }
+  fprintf(out, "$end\n");
+
+  last_ns = 0;
+  for(int i=0; i<count; i++) {
+    if(events[i].ns != last_ns) {      //#0 is already open
+      fprintf(out, "#%llu\n", (unsigned long long)events[i].ns);
+      last_ns = events[i].ns;
+    }
+    fprintf(out, "%d%c\n", events[i].value, signal_id(events[i].pin, events[i].type));
+  }
+
+  free(events);
+  if(in != stdin) {
+    fclose(in);
+  }
+  if(out != stdout) {
+    fclose(out);
+  }
+  return 0;
+}